@@ -0,0 +1,218 @@
+#include "DistributedXRayMachine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "XRayMachine.h"
+
+namespace xrt {
+    DistributedXRayMachine::DistributedXRayMachine(const size_t workers, const FilmCoordinate bandHeight) :
+        workers(workers),
+        bandHeight(bandHeight)
+    {
+        if (workers == 0 || bandHeight == 0)
+            throw std::invalid_argument("Need at least a worker and a row per band.");
+    }
+
+    void DistributedXRayMachine::scan(const Point& rayEmitter,
+                                      const std::vector<Mesh*> objects,
+                                      Film& film) const {
+        scan(rayEmitter, Scene(objects), film);
+    }
+
+    void DistributedXRayMachine::scan(const Point& rayEmitter,
+                                      const Scene& scene,
+                                      Film& film) const {
+        const BandIndex bands = (film.y_resolution + bandHeight - 1) / bandHeight;
+        const size_t crew = std::min<BandIndex>(workers, bands);
+
+        std::vector<pid_t> pids;
+        std::vector<int> channels;
+
+        // Shut down whoever is still around. On errors there is no point in waiting
+        // for the workers to finish their band.
+        auto dismiss = [&pids, &channels](const bool abort) {
+            for (const int channel : channels)
+                close(channel);
+            for (const pid_t pid : pids) {
+                if (abort)
+                    kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+            }
+        };
+
+        for (size_t w = 0; w < crew; ++w) {
+            int ends[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+                dismiss(true);
+                throw std::runtime_error("Can not open a channel to a worker.");
+            }
+
+            const pid_t pid = fork();
+            if (pid < 0) {
+                close(ends[0]);
+                close(ends[1]);
+                dismiss(true);
+                throw std::runtime_error("Can not start a worker.");
+            }
+
+            if (pid == 0) {
+                // Drop the channels of the other workers, or they never see the
+                // coordinator hanging up. _exit, not exit: the copies of the parent
+                // buffers (open files...) must not be flushed twice.
+                for (const int channel : channels)
+                    close(channel);
+                close(ends[0]);
+
+                try {
+                    work(ends[1], rayEmitter, scene, film);
+                } catch (...) {
+                    _exit(1);
+                }
+                _exit(0);
+            }
+
+            close(ends[1]);
+            pids.push_back(pid);
+            channels.push_back(ends[0]);
+        }
+
+        try {
+            coordinate(channels, film);
+        } catch (...) {
+            dismiss(true);
+            throw;
+        }
+
+        dismiss(false);
+    }
+
+    FilmRegion DistributedXRayMachine::bandOf(const BandIndex band, const Film& film) const {
+        const FilmCoordinate firstRow = band * bandHeight;
+        return FilmRegion{
+            0,
+            firstRow,
+            film.x_resolution,
+            std::min(bandHeight, film.y_resolution - firstRow)
+        };
+    }
+
+    void DistributedXRayMachine::work(const int channel,
+                                      const Point& rayEmitter,
+                                      const Scene& scene,
+                                      const Film& film) const {
+        XRayMachine machine;
+
+        while (true) {
+            BandIndex band;
+            receive(channel, &band, sizeof(band));
+            if (band == noMoreBands)
+                return;
+
+            // The band is a crop: same pixels, same levels of detail, same image
+            // as scanning the whole film in one go.
+            const FilmRegion region = bandOf(band, film);
+            Film strip = film.crop(region);
+            machine.scan(rayEmitter, scene, strip);
+
+            std::vector<Intensity> pixels;
+            pixels.reserve(strip.x_resolution * strip.y_resolution);
+            for (FilmCoordinate y = 0; y < strip.y_resolution; ++y)
+                for (FilmCoordinate x = 0; x < strip.x_resolution; ++x)
+                    pixels.push_back(strip.pixel(x, y));
+
+            send(channel, &band, sizeof(band));
+            send(channel, pixels.data(), pixels.size());
+        }
+    }
+
+    void DistributedXRayMachine::coordinate(const std::vector<int>& channels, Film& film) const {
+        const BandIndex bands = (film.y_resolution + bandHeight - 1) / bandHeight;
+        BandIndex nextBand = 0;
+        size_t pending = 0;
+
+        // There are never more workers than bands: everyone gets one to start.
+        std::vector<pollfd> waiting;
+        for (const int channel : channels) {
+            send(channel, &nextBand, sizeof(nextBand));
+            ++nextBand;
+            ++pending;
+            waiting.push_back(pollfd{channel, POLLIN, 0});
+        }
+
+        std::vector<Intensity> pixels;
+        while (pending > 0) {
+            if (poll(waiting.data(), waiting.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Lost track of the workers.");
+            }
+
+            for (pollfd& worker : waiting) {
+                if (worker.fd < 0 || worker.revents == 0)
+                    continue;
+
+                // Whatever woke us up, reading tells: either a band or a dead worker.
+                BandIndex band;
+                receive(worker.fd, &band, sizeof(band));
+                if (band >= bands)
+                    throw std::runtime_error("A worker returned a band that does not exist.");
+
+                const FilmRegion region = bandOf(band, film);
+                pixels.resize(region.width * region.height);
+                receive(worker.fd, pixels.data(), pixels.size());
+
+                for (FilmCoordinate y = 0; y < region.height; ++y)
+                    for (FilmCoordinate x = 0; x < region.width; ++x)
+                        film.expose(x, region.y + y, pixels.at(x + region.width * y));
+                --pending;
+
+                if (nextBand < bands) {
+                    send(worker.fd, &nextBand, sizeof(nextBand));
+                    ++nextBand;
+                    ++pending;
+                } else {
+                    send(worker.fd, &noMoreBands, sizeof(noMoreBands));
+                    worker.fd = -1;  // Poll skips it from now on.
+                }
+            }
+        }
+    }
+
+    void DistributedXRayMachine::send(const int channel, const void* data, const size_t size) {
+        const char* cursor = static_cast<const char*>(data);
+        size_t left = size;
+        while (left > 0) {
+            // No SIGPIPE if the other side is gone: report it as an error instead.
+            const ssize_t sent = ::send(channel, cursor, left, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+                throw std::runtime_error("Can not send to the other process.");
+            cursor += sent;
+            left -= sent;
+        }
+    }
+
+    void DistributedXRayMachine::receive(const int channel, void* data, const size_t size) {
+        char* cursor = static_cast<char*>(data);
+        size_t left = size;
+        while (left > 0) {
+            const ssize_t received = ::recv(channel, cursor, left, 0);
+            if (received < 0 && errno == EINTR)
+                continue;
+            if (received <= 0)
+                throw std::runtime_error("The other process hung up.");
+            cursor += received;
+            left -= received;
+        }
+    }
+}
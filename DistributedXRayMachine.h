@@ -0,0 +1,66 @@
+#ifndef DISTRIBUTEDXRAYMACHINE_H
+#define DISTRIBUTEDXRAYMACHINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Film.h"
+#include "Mesh.h"
+#include "Scene.h"
+#include "Vector3.h"
+
+namespace xrt
+{
+    /** Same job as the XRayMachine, but shared among several worker processes.
+     * 
+     * The film is cut in bands of rows. Each worker receives a band, scans it and sends
+     * back the pixels, then asks for another one. Bands that cross a lot of geometry take
+     * longer, but the other workers keep pulling new bands in the meantime.
+     * 
+     * Workers are forked from the current process, so they find the scene already loaded
+     * and keep it for all their bands. They talk with the coordinator over a stream socket,
+     * the same protocol could run over the network.
+    */
+    class DistributedXRayMachine {
+        public:
+            /** Throws std::invalid_argument if there are no workers or the bands are empty. */
+            DistributedXRayMachine(const size_t workers, const FilmCoordinate bandHeight);
+
+            /** Throws std::runtime_error if workers can not be started or die on the job. */
+            void scan(const Point& rayEmitter,
+                     const std::vector<Mesh*> objects,
+                     Film& film) const;
+
+            void scan(const Point& rayEmitter,
+                     const Scene& scene,
+                     Film& film) const;
+
+        private:
+            using BandIndex = uint64_t;
+
+            /** Tells a worker that there are no more bands. */
+            static constexpr BandIndex noMoreBands = UINT64_MAX;
+
+            const size_t workers;
+            const FilmCoordinate bandHeight;
+
+            /** The rows of the film in the band. The last band may be shorter. */
+            FilmRegion bandOf(const BandIndex band, const Film& film) const;
+
+            /** Life of a worker process: scan bands until told to stop. */
+            void work(const int channel,
+                      const Point& rayEmitter,
+                      const Scene& scene,
+                      const Film& film) const;
+
+            /** Hands out the bands and develops the results on the film. */
+            void coordinate(const std::vector<int>& channels, Film& film) const;
+
+            /** Move the whole buffer trough the channel, or throw. */
+            static void send(const int channel, const void* data, const size_t size);
+            static void receive(const int channel, void* data, const size_t size);
+    };
+    
+}
+
+#endif
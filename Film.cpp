@@ -1,22 +1,64 @@
 #include "Film.h"
 
 #include <limits>
+#include <stdexcept>
 
 
 namespace xrt {
     Film::Film(const FilmCoordinate x_resolution, const FilmCoordinate y_resolution,
                const double z, const double extent) :
+        Film(x_resolution, y_resolution, z, extent,
+             0, 0, 1, 1, x_resolution, y_resolution)
+    { }
+
+    Film::Film(const FilmCoordinate x_resolution, const FilmCoordinate y_resolution,
+               const double z, const double extent,
+               const double x_first, const double y_first,
+               const double x_step, const double y_step,
+               const FilmCoordinate x_grid, const FilmCoordinate y_grid) :
         x_resolution(x_resolution),
         y_resolution(y_resolution),
         z(z),
         extent(extent),
+        x_first(x_first),
+        y_first(y_first),
+        x_step(x_step),
+        y_step(y_step),
+        x_grid(x_grid),
+        y_grid(y_grid),
         pixels(x_resolution * y_resolution, 0)
     { }
 
+    Film Film::crop(const FilmRegion& region) const {
+        return crop(region, region.width, region.height);
+    }
+
+    Film Film::crop(const FilmRegion& region,
+                    const FilmCoordinate x_resolution, const FilmCoordinate y_resolution) const {
+        if (region.width == 0 || region.height == 0 ||
+            x_resolution == 0 || y_resolution == 0 ||
+            region.x + region.width > this->x_resolution ||
+            region.y + region.height > this->y_resolution)
+            throw std::out_of_range("Film region outside the film.");
+
+        // Crops of crops are fine: compose the steps so that everything stays on the 
+        // grid of the very first film.
+        return Film(x_resolution, y_resolution, z, extent,
+                    x_first + region.x * x_step,
+                    y_first + region.y * y_step,
+                    x_step * region.width / x_resolution,
+                    y_step * region.height / y_resolution,
+                    x_grid, y_grid);
+    }
+
     void Film::expose(const FilmCoordinate x, const FilmCoordinate y, Intensity i) {
         pixels.at(indexOf(x, y)) = i;
     }
 
+    Intensity Film::pixel(const FilmCoordinate x, const FilmCoordinate y) const {
+        return pixels.at(indexOf(x, y));
+    }
+
 
     void Film::dumpPGM(std::ostream& sink) const {
         sink << "P2\n";
@@ -35,11 +77,15 @@ namespace xrt {
         /* The point (0, 0) is where the Z axis pierces the screen. So (x, y) has 
            to be translated by half the amount of pixels (..._resolution / 2).
            Then such position can be multiplied by the dimension of a pixel along the
-           side (extent / resolution) to find the place where the pixel is. */
+           side (extent / resolution) to find the place where the pixel is.
+           For a crop, first find where the pixel falls on the original film. */
+
+        const double grid_x = x_first + x * x_step;
+        const double grid_y = y_first + y * y_step;
 
         return Point{ // cast to double beause may go negative
-            ((double) x - (double) x_resolution / 2) * extent / x_resolution,
-            ((double) y - (double) y_resolution / 2) * extent / y_resolution,
+            (grid_x - (double) x_grid / 2) * extent / x_grid,
+            (grid_y - (double) y_grid / 2) * extent / y_grid,
             z
         };
     }
@@ -16,6 +16,14 @@ namespace xrt {
     using Intensity = uint8_t;      // Matches the PGM format.
     using FilmCoordinate = size_t;  // Index in a matrix.
 
+    /** Rectangle of pixels, in the coordinates of the film it is cut from. */
+    struct FilmRegion {
+        FilmCoordinate x;
+        FilmCoordinate y;
+        FilmCoordinate width;
+        FilmCoordinate height;
+    };
+
     class Film {
         public:
             /* Assume that the film is parallel to the XY plane (vertical) at depth z
@@ -28,12 +36,29 @@ namespace xrt {
             Film(const FilmCoordinate x_resolution, const FilmCoordinate y_resolution,
                  const double z, const double extent);
 
+            /** Cuts a region of interest out of the film, at the same pixel pitch.
+             * 
+             *  The result is a new, blank film that covers only the region: scanning it
+             *  costs as many rays as the region has pixels, not as the whole film.
+             *  Throws std::out_of_range if the region does not fit in the film.
+            */
+            Film crop(const FilmRegion& region) const;
+
+            /** Same as the other crop, but spreads x_resolution by y_resolution pixels
+             *  over the region, to "zoom" on a detail at higher resolution.
+            */
+            Film crop(const FilmRegion& region,
+                      const FilmCoordinate x_resolution, const FilmCoordinate y_resolution) const;
+
             /** Send light to the pixel, setting the intensity. 
              * 
              * 0 means black.
             */
             void expose(const FilmCoordinate x, const FilmCoordinate y, Intensity i);
 
+            /** What the pixel received so far. */
+            Intensity pixel(const FilmCoordinate x, const FilmCoordinate y) const;
+
             /** Writes the data as the content of a PGM file. 
              *
              *  Does not write the file directly to allow testing/decouple from the saving itself.
@@ -60,9 +85,26 @@ namespace xrt {
             const FilmCoordinate y_resolution;
 
         private:
+            /** Crops are still placed with the grid of the original film: pixel x of
+             *  the crop sits at x_first + x * x_step pixels of the original, which has
+             *  x_grid pixels per side (same on y). A full film starts at 0 with step 1.
+            */
+            Film(const FilmCoordinate x_resolution, const FilmCoordinate y_resolution,
+                 const double z, const double extent,
+                 const double x_first, const double y_first,
+                 const double x_step, const double y_step,
+                 const FilmCoordinate x_grid, const FilmCoordinate y_grid);
+
             const double z;
             const double extent;
 
+            const double x_first;
+            const double y_first;
+            const double x_step;
+            const double y_step;
+            const FilmCoordinate x_grid;
+            const FilmCoordinate y_grid;
+
             /** Linearized 2D matrix, nothing fancy. */
             std::vector<Intensity> pixels;
 
@@ -1,8 +1,12 @@
 #include "Mesh.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <map>
+#include <set>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 namespace xrt {
@@ -26,8 +30,11 @@ namespace xrt {
     };
 
 
-    Mesh::Mesh(std::istream& objFileContent) {
+    Mesh::Mesh(std::istream& objFileContent, const size_t levelsOfDetail) :
+        bounds{}
+    {
         std::vector<Point> points;
+        std::vector<Corners> triangles;
         points.push_back(Point());  // OBJ indices start from one. Add a "padding" point to match.
 
         std::string line;
@@ -54,6 +61,7 @@ namespace xrt {
                     points.at(c)
                 };
                 faces.emplace_back(t);
+                triangles.push_back({(size_t) a, (size_t) b, (size_t) c});
             }
 
             else if(startsWith(line, "usemtl ")) {
@@ -63,17 +71,35 @@ namespace xrt {
                 shieldingStrength = materialsLib.at(material);
             }
         }
+
+        if (! faces.empty()) {
+            bounds.lower = bounds.upper = faces.front().A;
+            for (const Triangle& face : faces)
+                for (const Point& p : {face.A, face.B, face.C}) {
+                    bounds.lower = {std::min(bounds.lower.x, p.x), std::min(bounds.lower.y, p.y), std::min(bounds.lower.z, p.z)};
+                    bounds.upper = {std::max(bounds.upper.x, p.x), std::max(bounds.upper.y, p.y), std::max(bounds.upper.z, p.z)};
+                }
+        }
+
+        simplify(points, triangles, levelsOfDetail);
     }
 
 
+    std::vector<Point> Mesh::rayIntersection(const Ray& R) const{
+        return rayIntersection(R, 0);
+    }
+
     /* Brute force at its finest. Loop over all the triangles, no exceptions,
        every time. 
 
        Some optimization effort (like broad phase collision detection or a BSP)
        may be advantageous, but there is no time to implement it now.*/
-    std::vector<Point> Mesh::rayIntersection(const Ray& R) const{
+    std::vector<Point> Mesh::rayIntersection(const Ray& R, const size_t level) const{
+        const std::vector<Triangle>& levelFaces = 
+            (level == 0) ? faces : simplifications.at(level - 1).faces;
+
         std::vector<Point> hits;
-        for (const Triangle& face : faces) {
+        for (const Triangle& face : levelFaces) {
             Point hit;
             const int res = rayIntersection(R, face, hit);
 
@@ -83,6 +109,206 @@ namespace xrt {
         return hits;               
     }
 
+    size_t Mesh::levelOfDetail(const double tolerance) const {
+        for (size_t level = simplifications.size(); level > 0; --level)
+            if (simplifications.at(level - 1).error < tolerance)
+                return level;
+        return 0;
+    }
+
+    size_t Mesh::levelsOfDetail() const {
+        return simplifications.size() + 1;
+    }
+
+    const BoundingBox& Mesh::boundingBox() const {
+        return bounds;
+    }
+
+
+    /* Classic edge collapse: pick the cheapest edges, merge their ends in the midpoint.
+       Each collapse removes the two triangles on the edge.
+       
+       The error of a level is a (pessimistic) estimate of how far the surface moved: every
+       vertex remembers how far it went off the surface, a merged vertex takes the worst of its
+       two ends plus the last step. Edges on flat areas go first, they cost nothing.
+       
+       Each level may stray twice as far as the previous one. */
+    void Mesh::simplify(std::vector<Point> points,
+                        std::vector<Corners> triangles,
+                        const size_t levels) {
+        std::vector<double> displacement(points.size(), 0);
+
+        // Start from details too small to see at any reasonable resolution.
+        double budget = bounds.lower.distance(bounds.upper) / 1024;
+
+        for (size_t level = 0; level < levels; ++level, budget *= 2) {
+            const size_t previousSize = triangles.size();
+            while (collapseEdges(points, displacement, triangles, budget) > 0)
+                ;
+
+            if (triangles.size() == previousSize)
+                continue;  // Nothing to gain. Maybe with a bigger budget.
+
+            Simplification simplification;
+            simplification.error = *std::max_element(displacement.begin(), displacement.end());
+            for (const Corners& c : triangles)
+                simplification.faces.emplace_back(points.at(c[0]), points.at(c[1]), points.at(c[2]));
+            simplifications.emplace_back(simplification);
+        }
+    }
+
+    size_t Mesh::collapseEdges(std::vector<Point>& points,
+                               std::vector<double>& displacement,
+                               std::vector<Corners>& triangles,
+                               const double budget) const {
+        using Edge = std::pair<size_t, size_t>;  // Smallest index first.
+
+        std::vector<std::vector<size_t>> facesOf(points.size());
+        std::map<Edge, int> facesOnEdge;
+        for (size_t f = 0; f < triangles.size(); ++f)
+            for (size_t k = 0; k < 3; ++k) {
+                const size_t from = triangles.at(f)[k];
+                const size_t to = triangles.at(f)[(k + 1) % 3];
+                facesOf.at(from).push_back(f);
+                facesOnEdge[std::minmax(from, to)]++;
+            }
+
+        // Vertices that can not move in this round.
+        std::vector<bool> locked(points.size(), false);
+
+        // Leave borders and non-manifold edges alone. Moving them may open holes
+        // in the volume: the scan would lose track of what is inside and outside.
+        for (const auto& [edge, count] : facesOnEdge)
+            if (count != 2)
+                locked.at(edge.first) = locked.at(edge.second) = true;
+
+        std::vector<Edge> candidates;
+        for (const auto& [edge, count] : facesOnEdge)
+            if (! locked.at(edge.first) && ! locked.at(edge.second))
+                candidates.push_back(edge);
+
+        auto neighbours = [&](const size_t vertex) {
+            std::set<size_t> ring;
+            for (const size_t f : facesOf.at(vertex))
+                for (const size_t other : triangles.at(f))
+                    if (other != vertex)
+                        ring.insert(other);
+            return ring;
+        };
+
+        auto contains = [](const Corners& c, const size_t vertex) {
+            return std::find(c.begin(), c.end(), vertex) != c.end();
+        };
+
+        auto midpoint = [&points](const Edge& e) {
+            return (points.at(e.first) + points.at(e.second)) * 0.5;
+        };
+
+        // How far the midpoint is from the planes of the faces around the edge.
+        // Sliding along a flat surface costs nothing, the volume does not change.
+        auto deviation = [&](const Edge& e) {
+            const Point m = midpoint(e);
+            double worst = 0;
+            for (const size_t vertex : {e.first, e.second})
+                for (const size_t f : facesOf.at(vertex)) {
+                    const Corners& c = triangles.at(f);
+                    const Vector3 normal = (points.at(c[1]) - points.at(c[0])).crossProduct(points.at(c[2]) - points.at(c[0]));
+                    if (normal.isZeroLength())
+                        continue;
+                    const double distance = std::fabs(normal.dotProduct(m - points.at(c[0]))) /
+                                            normal.distance(Vector3{0, 0, 0});
+                    worst = std::max(worst, distance);
+                }
+            return worst;
+        };
+
+        std::vector<std::pair<double, Edge>> ranking;
+        for (const Edge& e : candidates)
+            ranking.emplace_back(deviation(e), e);
+        std::sort(ranking.begin(), ranking.end());
+
+        // A face that turns upside down when the vertex moves folds the surface on itself.
+        auto flips = [&](const size_t vertex, const size_t otherEnd, const Point& destination) {
+            for (const size_t f : facesOf.at(vertex)) {
+                const Corners& c = triangles.at(f);
+                if (contains(c, otherEnd))
+                    continue;  // Disappears anyway.
+
+                Point moved[3];
+                for (size_t k = 0; k < 3; ++k)
+                    moved[k] = (c[k] == vertex) ? destination : points.at(c[k]);
+
+                const Vector3 before = (points.at(c[1]) - points.at(c[0])).crossProduct(points.at(c[2]) - points.at(c[0]));
+                const Vector3 after = (moved[1] - moved[0]).crossProduct(moved[2] - moved[0]);
+                if (before.dotProduct(after) <= 0)
+                    return true;
+            }
+            return false;
+        };
+
+        std::vector<bool> gone(triangles.size(), false);
+        size_t removed = 0;
+
+        for (const auto& [cost, edge] : ranking) {
+            const auto [a, b] = edge;
+            if (locked.at(a) || locked.at(b))
+                continue;
+
+            const double error = std::max(displacement.at(a), displacement.at(b)) + cost;
+            if (error > budget)
+                continue;
+
+            const std::set<size_t> ringA = neighbours(a);
+            const std::set<size_t> ringB = neighbours(b);
+
+            // Only the two vertices in front of the edge may be connected to both ends,
+            // otherwise the collapse pinches the surface. The merged vertex also needs
+            // at least 3 neighbours, or the volume flattens (think of a tetrahedron).
+            std::set<size_t> common, ring;
+            for (const size_t v : ringA)
+                if (v != b) {
+                    ring.insert(v);
+                    if (ringB.count(v))
+                        common.insert(v);
+                }
+            for (const size_t v : ringB)
+                if (v != a)
+                    ring.insert(v);
+            
+            if (common.size() != 2 || ring.size() < 3)
+                continue;
+
+            const Point destination = midpoint(edge);
+            if (flips(a, b, destination) || flips(b, a, destination))
+                continue;
+
+            for (const size_t f : facesOf.at(b)) {
+                Corners& c = triangles.at(f);
+                if (contains(c, a)) {
+                    gone.at(f) = true;
+                    ++removed;
+                } else {
+                    std::replace(c.begin(), c.end(), b, a);
+                }
+            }
+
+            displacement.at(a) = error;
+            points.at(a) = destination;
+
+            locked.at(a) = locked.at(b) = true;
+            for (const size_t v : ring)
+                locked.at(v) = true;
+        }
+
+        std::vector<Corners> survivors;
+        for (size_t f = 0; f < triangles.size(); ++f)
+            if (! gone.at(f))
+                survivors.push_back(triangles.at(f));
+        triangles.swap(survivors);
+
+        return removed;
+    }
+
 
 
  /* Ray-Triangle intersection, recycled from 
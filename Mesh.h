@@ -1,6 +1,7 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include <array>
 #include <istream>
 #include <string>
 #include <unordered_map>
@@ -31,20 +32,45 @@ namespace xrt {
 
         const bool degenerate;
     };
+
+    /** Axis aligned box that contains a mesh. */
+    struct BoundingBox {
+        Point lower;
+        Point upper;
+    };
     
     /** Representation of a mesh, "tuned" for what this project needs. */
     class Mesh {
         public:
             /** May not work on a fully-fledged obj file. Implements just
              * what I need to read what comes out of Blender.
+             * 
+             * Can prepare up to levelsOfDetail simplified copies of the mesh, each
+             * allowed to stray twice as far from the original as the previous one.
+             * See levelOfDetail.
             */
-            Mesh(std::istream& objFileContent);
+            Mesh(std::istream& objFileContent, const size_t levelsOfDetail = 0);
 
             /** Returns a list of intersection points between the mesh and R, in no
              *  particular order.
             */
             std::vector<Point> rayIntersection(const Ray& R) const;
 
+            /** Same as above, but on a simplified copy of the mesh. Level 0 is the
+             *  mesh as loaded.
+            */
+            std::vector<Point> rayIntersection(const Ray& R, const size_t level) const;
+
+            /** Picks the coarsest level where no point of the surface moved more than
+             *  tolerance away from where it was. Level 0 if nothing is good enough.
+            */
+            size_t levelOfDetail(const double tolerance) const;
+
+            /** How many levels are available, including the full detail one. */
+            size_t levelsOfDetail() const;
+
+            const BoundingBox& boundingBox() const;
+
             /* Ray-Triangle intersection
 
                 Input:  a ray R, and a triangle T
@@ -64,6 +90,14 @@ namespace xrt {
             double shieldingStrength;
 
           private:
+            using Corners = std::array<size_t, 3>;  // Indices of the vertices of a triangle.
+
+            /** A cheaper copy of the mesh and how much it strays from the original. */
+            struct Simplification {
+                std::vector<Triangle> faces;
+                double error;
+            };
+
             /** Maps the material name to the shielding strenght.
              *  There may be "cooler" ways than hardcoding, like using the colors
              *  from the actual material to represent its resistance to x-rays rather
@@ -80,6 +114,27 @@ namespace xrt {
             */
             std::vector<Triangle> faces;
 
+            /** From the finest to the coarsest, all coarser than faces. */
+            std::vector<Simplification> simplifications;
+
+            BoundingBox bounds;
+
+            /** Fills the simplifications collapsing edges of the mesh, made of the given 
+             *  points and triangles. Skips the levels that would not remove anything.
+            */
+            void simplify(std::vector<Point> points,
+                          std::vector<Corners> triangles,
+                          const size_t levels);
+
+            /** One round of edge collapses, as long as no vertex strays more than budget from
+             *  the original surface. Never touches a vertex twice in the same round,
+             *  so that all the checks are done on the mesh as it is.
+             *  Returns how many triangles it removed.
+            */
+            size_t collapseEdges(std::vector<Point>& points,
+                                 std::vector<double>& displacement,
+                                 std::vector<Corners>& triangles,
+                                 const double budget) const;
     };
 }
 
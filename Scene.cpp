@@ -0,0 +1,50 @@
+#include "Scene.h"
+
+#include <algorithm>
+
+namespace xrt {
+    Scene::Scene()
+    {}
+
+    Scene::Scene(const std::vector<Mesh*>& objects) {
+        for (const Mesh* object : objects)
+            add(*object);
+    }
+
+    size_t Scene::add(const Mesh& mesh, const Transform& placement) {
+        parts.push_back(MeshInstance{&mesh, placement, Transform(), BoundingBox{}});
+        refit(parts.back());
+        return parts.size() - 1;
+    }
+
+    void Scene::move(const size_t instance, const Transform& placement) {
+        MeshInstance& moved = parts.at(instance);
+        moved.placement = placement;
+        refit(moved);
+    }
+
+    const std::vector<MeshInstance>& Scene::instances() const {
+        return parts;
+    }
+
+    void Scene::refit(MeshInstance& instance) const {
+        instance.inverse = instance.placement.inverse();
+
+        /* Box around the transformed corners of the mesh box. Not the tightest fit
+           (that would need all the vertices), but it costs the same for any mesh and
+           it is done once per move, not once per ray. */
+        const BoundingBox& local = instance.mesh->boundingBox();
+        bool first = true;
+        for (const double x : {local.lower.x, local.upper.x})
+            for (const double y : {local.lower.y, local.upper.y})
+                for (const double z : {local.lower.z, local.upper.z}) {
+                    const Point p = instance.placement.apply(Point{x, y, z});
+                    if (first) {
+                        instance.bounds.lower = instance.bounds.upper = p;
+                        first = false;
+                    }
+                    instance.bounds.lower = {std::min(instance.bounds.lower.x, p.x), std::min(instance.bounds.lower.y, p.y), std::min(instance.bounds.lower.z, p.z)};
+                    instance.bounds.upper = {std::max(instance.bounds.upper.x, p.x), std::max(instance.bounds.upper.y, p.y), std::max(instance.bounds.upper.z, p.z)};
+                }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vector>
+
+#include "Mesh.h"
+#include "Transform.h"
+
+namespace xrt {
+
+    /** A mesh placed somewhere in the scene.
+     *
+     *  The mesh is shared, not copied: many instances of the same mesh cost one set of triangles.
+     *  The inverse of the placement and the bounding box in the scene are cached to save
+     *  recomputing them for every ray.
+    */
+    struct MeshInstance {
+        const Mesh* mesh;
+        Transform placement;
+        Transform inverse;
+        BoundingBox bounds;
+    };
+
+    /** Collection of instances, ready to go in the XRayMachine.
+     *
+     *  To make a sequence of frames, move the instances and scan again: moving only
+     *  updates what changed, the meshes are left as they are.
+    */
+    class Scene {
+        public:
+            Scene();
+
+            /** One instance for each mesh, where the mesh already is. */
+            Scene(const std::vector<Mesh*>& objects);
+
+            /** Returns the index of the instance, to move it later.
+             *  The mesh must outlive the scene.
+            */
+            size_t add(const Mesh& mesh, const Transform& placement = Transform());
+
+            void move(const size_t instance, const Transform& placement);
+
+            const std::vector<MeshInstance>& instances() const;
+
+        private:
+            std::vector<MeshInstance> parts;
+
+            /** Recomputes the cached data after a change in the placement. */
+            void refit(MeshInstance& instance) const;
+    };
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "Transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace xrt {
+    Transform::Transform() :
+        m{{1, 0, 0, 0},
+          {0, 1, 0, 0},
+          {0, 0, 1, 0}}
+    {}
+
+    Transform Transform::translation(const Vector3& offset) {
+        Transform t;
+        t.m[0][3] = offset.x;
+        t.m[1][3] = offset.y;
+        t.m[2][3] = offset.z;
+        return t;
+    }
+
+    Transform Transform::scaling(const Vector3& factors) {
+        Transform t;
+        t.m[0][0] = factors.x;
+        t.m[1][1] = factors.y;
+        t.m[2][2] = factors.z;
+        return t;
+    }
+
+    Transform Transform::rotation(const Direction& axis, const double radians) {
+        // Rodrigues' formula, as matrix: https://en.wikipedia.org/wiki/Rotation_matrix#Rotation_matrix_from_axis_and_angle
+        const Direction u = axis * (1 / axis.distance(Vector3{0, 0, 0}));
+        const double c = std::cos(radians);
+        const double s = std::sin(radians);
+        const double k = 1 - c;
+
+        Transform t;
+        t.m[0][0] = c + u.x * u.x * k;
+        t.m[0][1] = u.x * u.y * k - u.z * s;
+        t.m[0][2] = u.x * u.z * k + u.y * s;
+        t.m[1][0] = u.y * u.x * k + u.z * s;
+        t.m[1][1] = c + u.y * u.y * k;
+        t.m[1][2] = u.y * u.z * k - u.x * s;
+        t.m[2][0] = u.z * u.x * k - u.y * s;
+        t.m[2][1] = u.z * u.y * k + u.x * s;
+        t.m[2][2] = c + u.z * u.z * k;
+        return t;
+    }
+
+    Transform Transform::operator*(const Transform& other) const {
+        Transform t;
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 4; ++column)
+                t.m[row][column] = m[row][0] * other.m[0][column] +
+                                   m[row][1] * other.m[1][column] +
+                                   m[row][2] * other.m[2][column];
+            t.m[row][3] += m[row][3];
+        }
+        return t;
+    }
+
+    Point Transform::apply(const Point& p) const {
+        return Point{
+            m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+            m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+            m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]
+        };
+    }
+
+    Transform Transform::inverse() const {
+        // Invert the 3x3 part with the adjugate, then undo the translation:
+        // if y = M x + t then x = M^-1 y - M^-1 t.
+        const Vector3 r0{m[0][0], m[0][1], m[0][2]};
+        const Vector3 r1{m[1][0], m[1][1], m[1][2]};
+        const Vector3 r2{m[2][0], m[2][1], m[2][2]};
+
+        // The columns of the inverse are the cross products of the rows.
+        const Vector3 c0 = r1.crossProduct(r2);
+        const Vector3 c1 = r2.crossProduct(r0);
+        const Vector3 c2 = r0.crossProduct(r1);
+
+        const double determinant = r0.dotProduct(c0);
+        if (determinant == 0)
+            throw std::domain_error("Transformation without inverse.");
+
+        Transform t;
+        t.m[0][0] = c0.x / determinant; t.m[0][1] = c1.x / determinant; t.m[0][2] = c2.x / determinant;
+        t.m[1][0] = c0.y / determinant; t.m[1][1] = c1.y / determinant; t.m[1][2] = c2.y / determinant;
+        t.m[2][0] = c0.z / determinant; t.m[2][1] = c1.z / determinant; t.m[2][2] = c2.z / determinant;
+
+        const Point moved = t.apply(Point{m[0][3], m[1][3], m[2][3]});
+        t.m[0][3] = -moved.x;
+        t.m[1][3] = -moved.y;
+        t.m[2][3] = -moved.z;
+        return t;
+    }
+
+    double Transform::stretch() const {
+        // The largest singular value is never more than sqrt(max column sum * max row sum).
+        double columns = 0;
+        double rows = 0;
+        for (int i = 0; i < 3; ++i) {
+            columns = std::max(columns, std::fabs(m[0][i]) + std::fabs(m[1][i]) + std::fabs(m[2][i]));
+            rows = std::max(rows, std::fabs(m[i][0]) + std::fabs(m[i][1]) + std::fabs(m[i][2]));
+        }
+        return std::sqrt(columns * rows);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "Vector3.h"
+
+namespace xrt {
+
+    /** Affine transformation: a 3x3 matrix plus a translation.
+     *
+     *  Just what is needed to place copies of a mesh around the scene.
+    */
+    class Transform {
+        public:
+            /** The identity: leaves everything where it is. */
+            Transform();
+
+            static Transform translation(const Vector3& offset);
+            static Transform scaling(const Vector3& factors);
+
+            /** Right hand rule around the axis, which needs not be normalized. */
+            static Transform rotation(const Direction& axis, const double radians);
+
+            /** Composition: applies other first, then this. */
+            Transform operator*(const Transform& other) const;
+
+            Point apply(const Point& p) const;
+
+            /** Throws std::domain_error if the transformation flattens space (zero scale...). */
+            Transform inverse() const;
+
+            /** Upper bound of how much a segment can get longer when transformed.
+             *  Exact for scales and translations, may overestimate with rotations.
+            */
+            double stretch() const;
+
+        private:
+            /** Rows of the matrix, the translation is in the last column. */
+            double m[3][4];
+    };
+}
+
+#endif
@@ -1,32 +1,138 @@
 #include "XRayMachine.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace xrt {
     void XRayMachine::scan(const Point& rayEmitter,
                            const std::vector<Mesh*> objects,
                            Film& film) {
-    
-    /* Brute force it: for every pixel, send the ray through every mesh.
-       For simple model and small images like the one I am aiming for, this is enough. */
+        scan(rayEmitter, Scene(objects), std::vector<Film*>{&film});
+    }
 
-    for (size_t x = 0; x < film.x_resolution ; ++x)
-        for (size_t y = 0; y < film.y_resolution ; ++y) {
+    void XRayMachine::scan(const Point& rayEmitter,
+                           const std::vector<Mesh*> objects,
+                           const std::vector<Film*> films) {
+        scan(rayEmitter, Scene(objects), films);
+    }
+
+    void XRayMachine::scan(const Point& rayEmitter,
+                           const Scene& scene,
+                           Film& film) {
+        scan(rayEmitter, scene, std::vector<Film*>{&film});
+    }
+
+    void XRayMachine::scan(const Point& rayEmitter,
+                           const Scene& scene,
+                           const std::vector<Film*> films) {
+        const std::vector<MeshInstance>& instances = scene.instances();
+
+        /* Brute force it: for every pixel, send the ray through every mesh.
+           For simple model and small images like the one I am aiming for, this is enough.
+           Crops only have the pixels of the region, so they cost only what they cover. */
+
+        for (Film* film : films) {
+            // Simplified meshes are fine as long as the film can not see the difference.
+            // Zooming on a crop may require more detail than the full film.
+            // Enlarged instances need more detail too.
+            std::vector<size_t> levels;
+            for (const MeshInstance& instance : instances)
+                levels.push_back(instance.mesh->levelOfDetail(
+                    tolerance(rayEmitter, instance.bounds, *film) / instance.placement.stretch()));
+
+            for (size_t x = 0; x < film->x_resolution ; ++x)
+                for (size_t y = 0; y < film->y_resolution ; ++y) {
+                    Ray R(rayEmitter, film->positionsOfPixel(x, y));
+                    film->expose(x, y, exposure(R, instances, levels));
+                }
+        }
+    }
+
+    double XRayMachine::tolerance(const Point& rayEmitter,
+                                  const BoundingBox& bounds,
+                                  const Film& film) const {
+        /* The rays of a pixel make a pyramid with the tip on the emitter. Its section
+           shrinks going away from the film, and it is smallest where the object is closest
+           to the emitter. The film is parallel to XY, so the distances that matter are
+           along Z. */
+        const Point corner = film.positionsOfPixel(0, 0);
+        const Point diagonal = film.positionsOfPixel(1, 1);
+        const double pixelSide = std::min(std::fabs(diagonal.x - corner.x),
+                                          std::fabs(diagonal.y - corner.y));
+
+        const double filmDistance = std::fabs(corner.z - rayEmitter.z);
+
+        // If the emitter is level with the object, the rays may graze it at any distance:
+        // no tolerance at all.
+        double objectDistance = 0;
+        if (rayEmitter.z < bounds.lower.z)
+            objectDistance = bounds.lower.z - rayEmitter.z;
+        else if (rayEmitter.z > bounds.upper.z)
+            objectDistance = rayEmitter.z - bounds.upper.z;
+
+        if (filmDistance == 0)
+            return 0;
+
+        return pixelSide * objectDistance / filmDistance;
+    }
+
+    bool XRayMachine::mayHit(const Ray& R, const BoundingBox& bounds) const {
+        /* Slab test: find where the ray enters and leaves the box along each axis,
+           it hits the box if it is inside all of them at the same time.
+           The ray starts at the emitter and goes on forever, like in the triangle test.
+           Pad the box a little, rounding must not drop hits at the very border. */
+        const double margin = 1e-6 * (1 + bounds.lower.distance(bounds.upper));
+        double enter = 0;
+        double leave = std::numeric_limits<double>::infinity();
+
+        auto slab = [&](const double origin, const double direction, const double lower, const double upper) {
+            if (direction == 0)
+                return origin >= lower - margin && origin <= upper + margin;
+
+            double near = (lower - margin - origin) / direction;
+            double far = (upper + margin - origin) / direction;
+            if (near > far)
+                std::swap(near, far);
+            enter = std::max(enter, near);
+            leave = std::min(leave, far);
+            return enter <= leave;
+        };
+
+        return slab(R.origin.x, R.direction.x, bounds.lower.x, bounds.upper.x) &&
+               slab(R.origin.y, R.direction.y, bounds.lower.y, bounds.upper.y) &&
+               slab(R.origin.z, R.direction.z, bounds.lower.z, bounds.upper.z);
+    }
+
+    Intensity XRayMachine::exposure(const Ray& R,
+                                    const std::vector<MeshInstance>& instances,
+                                    const std::vector<size_t>& levels) const {
+            const Point& rayEmitter = R.origin;
 
-            Ray R(rayEmitter, film.positionsOfPixel(x, y));
-            
             // Compute the intensity "in reverse". Traditional x-rays pictures
             // display the bones in white: high color intensity is where less x-ray
             // reached the film.
             double intensity = 255;
 
-            for (const Mesh* object : objects) {
-                std::vector<Point> hits = object->rayIntersection(R);
+            for (size_t i = 0; i < instances.size(); ++i) {
+                const MeshInstance& instance = instances.at(i);
+                const Mesh* object = instance.mesh;
+
+                if (! mayHit(R, instance.bounds))
+                    continue;
+
+                // Bring the ray to the mesh rather than moving every triangle to the ray.
+                // The hits come back in the scene, where distances are measured.
+                const Ray local(instance.inverse.apply(R.origin), instance.inverse.apply(R.target));
+                std::vector<Point> hits = object->rayIntersection(local, levels.at(i));
                 
                 if (hits.empty()) {
                     continue;
                 }
 
+                for (Point& hit : hits)
+                    hit = instance.placement.apply(hit);
+
                 /* Sort the points according to the distance with the emitter.
                  * Each pair of consecutive points "marks" a region inside or outside the
                  * object.
@@ -75,8 +181,6 @@ namespace xrt {
             if (intensity < 0)
                 intensity = 0;
             
-            film.expose(x, y, 255 - (Intensity) intensity);  // Reverse intensity - bones in white.
-        }
-
+            return 255 - (Intensity) intensity;  // Reverse intensity - bones in white.
     }
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 
 #include "Film.h"
 #include "Mesh.h"
+#include "Scene.h"
 #include "Vector3.h"
 
 namespace xrt
@@ -17,6 +18,40 @@ namespace xrt
             void scan(const Point& rayEmitter,
                      const std::vector<Mesh*> objects,
                      Film& film);
+
+            /** Scans several films (typically crops of the same film, see Film::crop) in
+             *  one go, with the same emitter and objects.
+            */
+            void scan(const Point& rayEmitter,
+                     const std::vector<Mesh*> objects,
+                     const std::vector<Film*> films);
+
+            /** Same as above, with meshes placed by instances rather than as they are. */
+            void scan(const Point& rayEmitter,
+                     const Scene& scene,
+                     Film& film);
+
+            void scan(const Point& rayEmitter,
+                     const Scene& scene,
+                     const std::vector<Film*> films);
+
+        private:
+            /** Sends a single ray trough the instances and tells how much the
+             *  film is exposed where it lands. Each instance is seen at its level of detail.
+            */
+            Intensity exposure(const Ray& R,
+                               const std::vector<MeshInstance>& instances,
+                               const std::vector<size_t>& levels) const;
+
+            /** False if the ray surely misses everything in the box. */
+            bool mayHit(const Ray& R, const BoundingBox& bounds) const;
+
+            /** How far the surface of an object in the bounding box can move before the
+             *  film notices: the size of a pixel, scaled down to the object closest point.
+            */
+            double tolerance(const Point& rayEmitter,
+                             const BoundingBox& bounds,
+                             const Film& film) const;
     };
     
 }
@@ -1,8 +1,14 @@
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <fstream>
+#include <thread>
 
+#include "DistributedXRayMachine.h"
 #include "Film.h"
 #include "Mesh.h"
+#include "Scene.h"
+#include "Transform.h"
 #include "Vector3.h"
 #include "XRayMachine.h"
 
@@ -30,6 +36,15 @@ static void tests() {
     rayOrigin = f.positionsOfPixel(f.x_resolution, f.y_resolution);
     assert(rayOrigin.x == 0.5 && rayOrigin.y == 0.5 && rayOrigin.z == 10);
 
+    xrt::Film detail = f.crop({256, 128, 64, 32});
+    assert(detail.x_resolution == 64 && detail.y_resolution == 32);
+    rayOrigin = detail.positionsOfPixel(0, 128);
+    assert(rayOrigin.x == 0 && rayOrigin.y == 0 && rayOrigin.z == 10);
+
+    xrt::Film zoom = f.crop({256, 256, 256, 256}, 512, 512);
+    rayOrigin = zoom.positionsOfPixel(512, 512);
+    assert(rayOrigin.x == 0.5 && rayOrigin.y == 0.5 && rayOrigin.z == 10);
+
     xrt::Vector3 a{0, 0, 0};
     xrt::Vector3 b{1, 0, -1};
     xrt::Vector3 r = a - b;
@@ -80,9 +95,77 @@ static void tests() {
     assert(hits.empty());
     hits = m.rayIntersection(cross_holeOnTop);
     assert(hits.size() == 2);
+
+    testMeshFile.open("./samples/skull.obj");
+    xrt::Mesh simplified(testMeshFile, 4);
+    testMeshFile.close();
+
+    assert(simplified.levelsOfDetail() > 1);
+    assert(simplified.levelOfDetail(0) == 0);
+    const size_t coarsest = simplified.levelOfDetail(1000);
+    assert(coarsest == simplified.levelsOfDetail() - 1);
+
+    const xrt::BoundingBox& box = simplified.boundingBox();
+    const xrt::Point center = (box.lower + box.upper) * 0.5;
+    xrt::Ray cross_skull{{center.x, center.y, box.upper.z + 1}, {center.x, center.y, box.lower.z - 1}};
+    hits = simplified.rayIntersection(cross_skull, coarsest);
+    assert(hits.size() == simplified.rayIntersection(cross_skull).size());  // Still closed.
+
+    // Bands of uneven size on purpose: the last one is shorter.
+    xrt::Film alone(48, 50, -3, 6);
+    xrt::Film together(48, 50, -3, 6);
+    const xrt::Point cubeEmitter{0.3, 0.2, 5};
+    xrt::XRayMachine().scan(cubeEmitter, {&m}, alone);
+    xrt::DistributedXRayMachine(3, 7).scan(cubeEmitter, {&m}, together);
+
+    bool exposed = false;
+    for (size_t i = 0; i < alone.x_resolution ; ++i)
+        for (size_t j = 0; j < alone.y_resolution ; ++j) {
+            assert(alone.pixel(i, j) == together.pixel(i, j));
+            exposed = exposed || alone.pixel(i, j) != 0;
+        }
+    assert(exposed);
+
+    const xrt::Transform shift = xrt::Transform::translation({0.75, 0, 0});
+    xrt::Point moved = shift.apply({1, 2, 3});
+    assert(moved.x == 1.75 && moved.y == 2 && moved.z == 3);
+    moved = shift.inverse().apply(moved);
+    assert(moved.x == 1 && moved.y == 2 && moved.z == 3);
+
+    const xrt::Transform quarterTurn = xrt::Transform::rotation(z, std::acos(0));
+    moved = quarterTurn.apply(x);
+    assert(moved.distance(y) < 1e-12);
+    moved = (quarterTurn.inverse() * quarterTurn).apply(x);
+    assert(moved.distance(x) < 1e-12);
+
+    // One cube, two places. Moving the instance refits its box.
+    xrt::Scene scene;
+    scene.add(m);
+    const size_t copy = scene.add(m, xrt::Transform::scaling({2, 2, 2}));
+    assert(scene.instances().at(copy).bounds.upper.x == 2 * m.boundingBox().upper.x);
+    scene.move(copy, shift);
+    assert(scene.instances().at(copy).bounds.upper.x == m.boundingBox().upper.x + 0.75);
+    assert(scene.instances().at(copy).mesh == scene.instances().front().mesh);
+
+    // Moving the cube and the emitter is like moving the film the other way.
+    // 0.75 is 8 pixels on this film.
+    xrt::Film wide(64, 64, -3, 6);
+    xrt::Film still = wide.crop({8, 8, 48, 48});
+    xrt::Film shifted = wide.crop({16, 8, 48, 48});
+    xrt::Scene single;
+    single.add(m, shift);
+    xrt::XRayMachine().scan(cubeEmitter, {&m}, still);
+    xrt::XRayMachine().scan(shift.apply(cubeEmitter), single, shifted);
+    for (size_t i = 0; i < still.x_resolution ; ++i)
+        for (size_t j = 0; j < still.y_resolution ; ++j)
+            assert(std::abs(still.pixel(i, j) - shifted.pixel(i, j)) <= 1);
 }
 
 int main(void) {
+    // Simplified meshes for when the film can not tell the difference. 0 to always use
+    // the full detail.
+    constexpr size_t levelsOfDetail = 6;
+
     // Uncomment when debugging.
     // tests();
     // return 0;
@@ -91,20 +174,20 @@ int main(void) {
     // https://github.com/makehumancommunity/makehuman/blob/master/LICENSE.md
     std::ifstream objectFile;
     objectFile.open("./samples/head.obj");
-    xrt::Mesh head(objectFile);
+    xrt::Mesh head(objectFile, levelsOfDetail);
     objectFile.close();
 
     //  Special thanks to https://design.tutsplus.com/articles/sculpt-model-and-texture-a-low-poly-skull-in-blender--cg-7
     objectFile.open("./samples/skull.obj");
-    xrt::Mesh skull(objectFile);
+    xrt::Mesh skull(objectFile, levelsOfDetail);
     objectFile.close();
 
     objectFile.open("./samples/spine.obj");
-    xrt::Mesh spine(objectFile);
+    xrt::Mesh spine(objectFile, levelsOfDetail);
     objectFile.close();
 
     objectFile.open("./samples/brain.obj");
-    xrt::Mesh brain(objectFile);
+    xrt::Mesh brain(objectFile, levelsOfDetail);
     objectFile.close();
 
     std::vector<xrt::Mesh*> modelParts = {&head, &skull, &brain, &spine};
@@ -112,7 +195,9 @@ int main(void) {
     xrt::Film film(256, 256, -1.1, 3.5);
     const xrt::Point emitter{0, 0, 4.1};
 
-    xrt::XRayMachine machine;
+    // One worker per core, bands small enough to keep them all busy until the end.
+    const size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    xrt::DistributedXRayMachine machine(workers, 4);
     machine.scan(emitter, modelParts, film);
 
     std::ofstream result;